@@ -3,12 +3,14 @@
 #include <stdlib.h>
 #include <string.h>
 #include <time.h>
+#include <stdatomic.h>
 
 #ifdef _WIN32
 #include <windows.h>
 #else
 #include <unistd.h>
 #include <sys/ioctl.h>
+#include <pthread.h>
 #endif
 
 // --- Configuration ---
@@ -21,9 +23,17 @@
 
 typedef struct { double x, y, z; } Vec3;
 
+typedef struct {
+    Vec3 trail[MAX_POINTS];
+    int head;
+    Vec3 p;
+    int system; // 0 = Thomas, 1 = Lorenz
+} Scene;
+
 // Global State
-Vec3 trail[MAX_POINTS];
-int head = 0;
+Scene scenes[2];
+Scene *scene = &scenes[0];
+_Atomic(Scene *) ready_scene = NULL; // Warmed-up scene published by the prefetch thread
 int width = 100, height = 40;
 double angle_x = 0, angle_y = 0;
 int current_system = 0; // 0 = Thomas, 1 = Lorenz
@@ -94,6 +104,96 @@ char get_density_char(int age) {
     return chars[5];
 }
 
+void reset_scene(Scene *s, int system) {
+    s->system = system;
+    s->p = (Vec3){0.1, 0.1, 0.1};
+    s->head = 0;
+    memset(s->trail, 0, sizeof(s->trail));
+}
+
+void step_scene(Scene *s) {
+    Vec3 p = s->p;
+    double dx, dy, dz;
+    if (s->system == 0) { // THOMAS
+        dx = sin(p.y) - THOMAS_B * p.x;
+        dy = sin(p.z) - THOMAS_B * p.y;
+        dz = sin(p.x) - THOMAS_B * p.z;
+    } else { // LORENZ
+        dx = LORENZ_S * (p.y - p.x);
+        dy = p.x * (LORENZ_R - p.z) - p.y;
+        dz = p.x * p.y - LORENZ_B * p.z;
+    }
+    
+    p.x += dx * (s->system == 1 ? 0.01 : DT);
+    p.y += dy * (s->system == 1 ? 0.01 : DT);
+    p.z += dz * (s->system == 1 ? 0.01 : DT);
+    
+    s->p = p;
+    s->trail[s->head] = p;
+    s->head = (s->head + 1) % MAX_POINTS;
+}
+
+// --- Next System Prefetch ---
+// While one scene plays, the other buffer is filled with a full trail of the
+// next system on a background thread and published through ready_scene. The
+// switch frame only exchanges the pointer and never waits on the worker.
+atomic_int prefetch_busy = 0;
+
+#ifdef _WIN32
+HANDLE prefetch_thread = NULL;
+
+DWORD WINAPI prefetch_worker(LPVOID arg) {
+#else
+pthread_t prefetch_thread;
+int prefetch_running = 0;
+
+void *prefetch_worker(void *arg) {
+#endif
+    Scene *s = (Scene *)arg;
+    for (int i = 0; i < MAX_POINTS; i++) step_scene(s);
+    atomic_store(&ready_scene, s);
+    atomic_store(&prefetch_busy, 0);
+    return 0;
+}
+
+// Only called once prefetch_busy is clear, so this just reaps the thread.
+void join_prefetch() {
+#ifdef _WIN32
+    if (prefetch_thread) {
+        WaitForSingleObject(prefetch_thread, INFINITE);
+        CloseHandle(prefetch_thread);
+        prefetch_thread = NULL;
+    }
+#else
+    if (prefetch_running) {
+        pthread_join(prefetch_thread, NULL);
+        prefetch_running = 0;
+    }
+#endif
+}
+
+// Called every frame: starts warming `system` in the spare buffer once the
+// previous worker is done and nothing of that system is already waiting.
+void poll_prefetch(int system) {
+    if (atomic_load(&prefetch_busy)) return;
+    join_prefetch();
+
+    Scene *waiting = atomic_load(&ready_scene);
+    if (waiting && waiting->system == system) return;
+    atomic_store(&ready_scene, NULL);
+
+    Scene *spare = (scene == &scenes[0]) ? &scenes[1] : &scenes[0];
+    reset_scene(spare, system);
+    atomic_store(&prefetch_busy, 1);
+#ifdef _WIN32
+    prefetch_thread = CreateThread(NULL, 0, prefetch_worker, spare, 0, NULL);
+    if (!prefetch_thread) atomic_store(&prefetch_busy, 0);
+#else
+    prefetch_running = pthread_create(&prefetch_thread, NULL, prefetch_worker, spare) == 0;
+    if (!prefetch_running) atomic_store(&prefetch_busy, 0);
+#endif
+}
+
 void intro_animation() {
     printf("\033[2J\033[H");
     const char* lines[] = {
@@ -119,36 +219,22 @@ int main() {
     setup_terminal();
     intro_animation();
 
-    Vec3 p = {0.1, 0, 0};
     char *frame_buf = malloc(width * height * 64);
     
     // Main loop
     for (int frame = 0; ; frame++) {
-        // Switch systems every 1000 frames
+        // Switch systems every 1000 frames, to the prefetched scene when there is one
         if (frame % 1000 == 0) {
-            current_system = (current_system + 1) % 2;
-            p = (Vec3){0.1, 0.1, 0.1};
-            memset(trail, 0, sizeof(trail));
+            int next_system = (current_system + 1) % 2;
+            Scene *warm = atomic_exchange(&ready_scene, NULL);
+            if (warm && warm->system == next_system) scene = warm;
+            else reset_scene(scene, next_system);
+            current_system = scene->system;
         }
+        poll_prefetch((current_system + 1) % 2);
 
         // 1. Update Math (Physics)
-        double dx, dy, dz;
-        if (current_system == 0) { // THOMAS
-            dx = sin(p.y) - THOMAS_B * p.x;
-            dy = sin(p.z) - THOMAS_B * p.y;
-            dz = sin(p.x) - THOMAS_B * p.z;
-        } else { // LORENZ
-            dx = LORENZ_S * (p.y - p.x);
-            dy = p.x * (LORENZ_R - p.z) - p.y;
-            dz = p.x * p.y - LORENZ_B * p.z;
-        }
-        
-        p.x += dx * (current_system == 1 ? 0.01 : DT);
-        p.y += dy * (current_system == 1 ? 0.01 : DT);
-        p.z += dz * (current_system == 1 ? 0.01 : DT);
-        
-        trail[head] = p;
-        head = (head + 1) % MAX_POINTS;
+        step_scene(scene);
 
         // 2. Clear buffers
         char out_chars[height][width];
@@ -158,12 +244,12 @@ int main() {
 
         // 3. Render Trajectory
         for (int i = 0; i < MAX_POINTS; i++) {
-            int idx = (head - 1 - i + MAX_POINTS) % MAX_POINTS;
-            if (trail[idx].x == 0) continue;
+            int idx = (scene->head - 1 - i + MAX_POINTS) % MAX_POINTS;
+            if (scene->trail[idx].x == 0) continue;
             
             int sx, sy;
             double depth;
-            project(trail[idx], &sx, &sy, &depth);
+            project(scene->trail[idx], &sx, &sy, &depth);
             
             if (sx >= 0 && sx < width && sy >= 0 && sy < height) {
                 if (i < out_ages[sy][sx]) {
@@ -5,14 +5,22 @@
 #include <chrono>
 #include <thread>
 #include <algorithm>
+#include <memory>
+#include <atomic>
+#include <cstdlib>
+#include <cstdio>
 
 #ifdef _WIN32
 #include <windows.h>
+#include <io.h>
+#include <fcntl.h>
 #else
 #include <sys/ioctl.h>
 #include <unistd.h>
 #endif
 
+#define PARAREAL_VERIFY_SAMPLES 64
+
 #ifndef ENABLE_VIRTUAL_TERMINAL_PROCESSING
 #define ENABLE_VIRTUAL_TERMINAL_PROCESSING 0x0004
 #endif
@@ -27,48 +35,130 @@ struct Particle {
     int age;
 };
 
+// --- Poincare Section ---
+// Keeps only the points where the orbit crosses the plane normal . p = offset
+// in the direction of the normal, refined by linear interpolation over the
+// step. Crossings are streamed as packed doubles (t, x, y, z).
+struct Crossing {
+    double t, x, y, z;
+};
+
+class PoincareSection {
+public:
+    PoincareSection(Vec3 normal, double offset, FILE* out)
+        : normal(normal), offset(offset), out(out), count(0) {
+        buffer.reserve(4096);
+    }
+
+    ~PoincareSection() { flush(); }
+
+    void observe(const Vec3& a, const Vec3& b, double t, double dt) {
+        double s0 = normal.x * a.x + normal.y * a.y + normal.z * a.z - offset;
+        double s1 = normal.x * b.x + normal.y * b.y + normal.z * b.z - offset;
+        if (!(s0 < 0.0 && s1 >= 0.0)) return;
+
+        double f = s0 / (s0 - s1);
+        buffer.push_back({t + f * dt, a.x + (b.x - a.x) * f, a.y + (b.y - a.y) * f, a.z + (b.z - a.z) * f});
+        count++;
+        if (buffer.size() == buffer.capacity()) flush();
+    }
+
+    void flush() {
+        if (out && !buffer.empty()) fwrite(buffer.data(), sizeof(Crossing), buffer.size(), out);
+        buffer.clear();
+    }
+
+    size_t get_count() const { return count; }
+
+private:
+    Vec3 normal;
+    double offset;
+    FILE* out;
+    size_t count;
+    std::vector<Crossing> buffer;
+};
+
 class ChaosSystem {
 public:
     enum Type { THOMAS, LORENZ, AIZAWA };
     
-    ChaosSystem(Type type = THOMAS) : type(type) {
+    ChaosSystem(Type type = THOMAS) : type(type), section(nullptr) {
         reset();
     }
 
     void reset() {
         p.x = 0.1; p.y = 0.1; p.z = 0.1;
+        time = 0.0;
         trail.clear();
         trail.reserve(3000);
     }
 
-    void update(double dt) {
-        double dx, dy, dz;
+    Vec3 derivative(const Vec3& q) const {
+        Vec3 out;
         switch (type) {
             case THOMAS: {
                 const double b = 0.19;
-                dx = std::sin(p.y) - b * p.x;
-                dy = std::sin(p.z) - b * p.y;
-                dz = std::sin(p.x) - b * p.z;
+                out.x = std::sin(q.y) - b * q.x;
+                out.y = std::sin(q.z) - b * q.y;
+                out.z = std::sin(q.x) - b * q.z;
                 break;
             }
             case LORENZ: {
                 const double s = 10.0, r = 28.0, b = 8.0/3.0;
-                dx = s * (p.y - p.x);
-                dy = p.x * (r - p.z) - p.y;
-                dz = p.x * p.y - b * p.z;
+                out.x = s * (q.y - q.x);
+                out.y = q.x * (r - q.z) - q.y;
+                out.z = q.x * q.y - b * q.z;
                 break;
             }
             case AIZAWA: {
                 const double a = 0.95, b = 0.7, c = 0.6, d = 3.5, e = 0.25, f = 0.1;
-                dx = (p.z - b) * p.x - d * p.y;
-                dy = d * p.x + (p.z - b) * p.y;
-                dz = c + a * p.z - std::pow(p.z, 3) / 3.0 - (std::pow(p.x, 2) + std::pow(p.y, 2)) * (1.0 + e * p.z) + f * p.z * std::pow(p.x, 3);
+                out.x = (q.z - b) * q.x - d * q.y;
+                out.y = d * q.x + (q.z - b) * q.y;
+                out.z = c + a * q.z - std::pow(q.z, 3) / 3.0 - (std::pow(q.x, 2) + std::pow(q.y, 2)) * (1.0 + e * q.z) + f * q.z * std::pow(q.x, 3);
                 break;
             }
         }
-        p.x += dx * dt;
-        p.y += dy * dt;
-        p.z += dz * dt;
+        return out;
+    }
+
+    // Headless propagators used by the Parareal mode; they leave the trail alone.
+    Vec3 integrate_heun(Vec3 q, double dt, long steps) const {
+        for (long i = 0; i < steps; i++) {
+            Vec3 k1 = derivative(q);
+            Vec3 k2 = derivative({q.x + k1.x * dt, q.y + k1.y * dt, q.z + k1.z * dt});
+            q.x += (k1.x + k2.x) * dt / 2;
+            q.y += (k1.y + k2.y) * dt / 2;
+            q.z += (k1.z + k2.z) * dt / 2;
+        }
+        return q;
+    }
+
+    Vec3 integrate_rk4(Vec3 q, double dt, long steps) const {
+        for (long i = 0; i < steps; i++) {
+            Vec3 k1 = derivative(q);
+            Vec3 k2 = derivative({q.x + k1.x * dt / 2, q.y + k1.y * dt / 2, q.z + k1.z * dt / 2});
+            Vec3 k3 = derivative({q.x + k2.x * dt / 2, q.y + k2.y * dt / 2, q.z + k2.z * dt / 2});
+            Vec3 k4 = derivative({q.x + k3.x * dt, q.y + k3.y * dt, q.z + k3.z * dt});
+            q.x += (k1.x + 2 * k2.x + 2 * k3.x + k4.x) * dt / 6;
+            q.y += (k1.y + 2 * k2.y + 2 * k3.y + k4.y) * dt / 6;
+            q.z += (k1.z + 2 * k2.z + 2 * k3.z + k4.z) * dt / 6;
+        }
+        return q;
+    }
+
+    // Advances the orbit without touching the trail.
+    void step(double dt) {
+        Vec3 prev = p;
+        Vec3 d = derivative(p);
+        p.x += d.x * dt;
+        p.y += d.y * dt;
+        p.z += d.z * dt;
+        if (section) section->observe(prev, p, time, dt);
+        time += dt;
+    }
+
+    void update(double dt) {
+        step(dt);
 
         Particle np = {p, 0};
         trail.insert(trail.begin(), np);
@@ -77,16 +167,419 @@ public:
         for (size_t i = 0; i < trail.size(); i++) trail[i].age++;
     }
 
+    // Runs a full trail's worth of frames so the attractor is already drawn out.
+    void warm_up() {
+        for (int i = 0; i < 3000; i++) update(step_size());
+    }
+
     const std::vector<Particle>& get_trail() const { return trail; }
     Type get_type() const { return type; }
+    double step_size() const { return type == THOMAS ? 0.05 : 0.01; }
+    const Vec3& get_position() const { return p; }
+    void set_position(const Vec3& q) { p = q; }
     void set_type(Type t) { type = t; reset(); }
+    void attach_section(PoincareSection* s) { section = s; }
 
 private:
     Type type;
     Vec3 p;
+    double time;
+    PoincareSection* section;
     std::vector<Particle> trail;
 };
 
+// --- Headless Mode Arguments ---
+// Positional arguments plus the --u0 x y z and --verify flags shared by the
+// headless modes.
+struct HeadlessArgs {
+    std::vector<std::string> positional;
+    bool verify = false;
+    bool has_u0 = false;
+    Vec3 u0 = {0.0, 0.0, 0.0};
+};
+
+bool parse_headless_args(int argc, char** argv, int first, HeadlessArgs& out) {
+    for (int i = first; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--verify") {
+            out.verify = true;
+        } else if (arg == "--u0") {
+            if (i + 3 >= argc) return false;
+            double v[3];
+            for (int k = 0; k < 3; k++) {
+                char* end;
+                v[k] = std::strtod(argv[i + 1 + k], &end);
+                if (end == argv[i + 1 + k] || *end != '\0') return false;
+            }
+            out.u0 = {v[0], v[1], v[2]};
+            out.has_u0 = true;
+            i += 3;
+        } else if (arg.compare(0, 2, "--") == 0) {
+            return false;
+        } else {
+            out.positional.push_back(arg);
+        }
+    }
+    return true;
+}
+
+// --u0 when given, otherwise the system's reset point. Thomas' reset point
+// (0.1, 0.1, 0.1) lies on its invariant diagonal and only falls into the
+// (2.62, 2.62, 2.62) fixed point, so headless Thomas runs start off it.
+Vec3 headless_start(const ChaosSystem& sys, const HeadlessArgs& args) {
+    if (args.has_u0) return args.u0;
+    if (sys.get_type() == ChaosSystem::THOMAS) return {1.0, 0.0, 0.0};
+    return sys.get_position();
+}
+
+// --- Parareal Parallel-in-Time Integration ---
+// Splits one long orbit into time slices. A cheap serial coarse sweep (Heun)
+// predicts every slice start, then the accurate fine propagator (RK4) runs on
+// all slices concurrently and the coarse sweep is corrected with its result:
+//   U[n+1] = G(U_new[n]) + F(U_old[n]) - G(U_old[n])
+struct PararealConfig {
+    long steps = 1000000;       // Fine RK4 steps over the whole run
+    int slices = 8;
+    int max_iterations = 8;
+    double tolerance = 1e-9;    // Stop once no slice start moves more than this
+    int coarse_ratio = 0;       // Fine steps per coarse Heun step, 0 = per-system default
+};
+
+class PararealSolver {
+public:
+    PararealSolver(const ChaosSystem& sys, double dt, const PararealConfig& cfg)
+        : sys(sys), dt(dt), cfg(cfg), iterations(0) {
+        for (int n = 0; n < cfg.slices; n++) {
+            slice_steps.push_back(cfg.steps / cfg.slices + (n < cfg.steps % cfg.slices ? 1 : 0));
+        }
+    }
+
+    // Returns the state at the start of every slice plus the final state.
+    std::vector<Vec3> solve(const Vec3& u0) {
+        int N = cfg.slices;
+        std::vector<Vec3> U(N + 1), G(N), F(N), F_start(N);
+        std::vector<bool> fine_valid(N, false);
+
+        U[0] = u0;
+        for (int n = 0; n < N; n++) {
+            G[n] = coarse(U[n], n);
+            U[n + 1] = G[n];
+        }
+
+        for (iterations = 1; iterations <= cfg.max_iterations; iterations++) {
+            // A slice whose start did not move keeps its previous fine result.
+            std::vector<int> work;
+            for (int n = 0; n < N; n++) {
+                if (!fine_valid[n] || !same(F_start[n], U[n])) work.push_back(n);
+            }
+            run_parallel(work, [&](int n) {
+                F_start[n] = U[n];
+                F[n] = fine(U[n], n);
+            });
+            for (int n : work) fine_valid[n] = true;
+
+            double correction = 0.0;
+            for (int n = 0; n < N; n++) {
+                // An unchanged start makes the correction exactly F; taking it
+                // directly keeps converged slices bit-identical to a serial run.
+                bool settled = same(U[n], F_start[n]);
+                Vec3 g = settled ? G[n] : coarse(U[n], n);
+                Vec3 next = settled ? F[n] : Vec3{ g.x + F[n].x - G[n].x, g.y + F[n].y - G[n].y, g.z + F[n].z - G[n].z };
+                // A diverged coarse step carries no information; fall back to the fine result.
+                if (!std::isfinite(next.x + next.y + next.z)) next = F[n];
+                // Written so a diverged (NaN) coarse sweep never reads as converged.
+                double moved = distance(next, U[n + 1]);
+                if (!(moved <= correction)) correction = moved;
+                G[n] = g;
+                U[n + 1] = next;
+            }
+            std::cout << "  iteration " << iterations << ": " << work.size() << " fine slices, max correction "
+                      << correction << "\n";
+            if (correction <= cfg.tolerance) break;
+        }
+        if (iterations > cfg.max_iterations) iterations = cfg.max_iterations;
+        return U;
+    }
+
+    // Serial fine solve sampled at the same slice starts, for verification.
+    std::vector<Vec3> solve_serial(const Vec3& u0) const {
+        std::vector<Vec3> U(cfg.slices + 1);
+        U[0] = u0;
+        for (int n = 0; n < cfg.slices; n++) U[n + 1] = fine(U[n], n);
+        return U;
+    }
+
+    // Re-integrates every slice from the starts of both runs and compares them
+    // `samples` times per slice, so divergence inside a slice is not hidden by
+    // agreement at its ends. Returns the first sampled time the runs differ by
+    // more than `tolerance`, or the end of the run if they never do.
+    double divergence_time(const std::vector<Vec3>& U, const std::vector<Vec3>& R, int samples,
+                           double tolerance, std::vector<double>& slice_max) const {
+        int N = cfg.slices;
+        std::vector<std::vector<double>> errors(N);
+        std::vector<int> all(N);
+        for (int n = 0; n < N; n++) all[n] = n;
+        run_parallel(all, [&](int n) {
+            long chunk = std::max(1L, slice_steps[n] / samples);
+            Vec3 a = U[n], b = R[n];
+            for (long done = 0; done < slice_steps[n]; done += chunk) {
+                long todo = std::min(chunk, slice_steps[n] - done);
+                a = sys.integrate_rk4(a, dt, todo);
+                b = sys.integrate_rk4(b, dt, todo);
+                errors[n].push_back(distance(a, b));
+            }
+        });
+
+        slice_max.assign(N, 0.0);
+        double first = -1.0;
+        for (int n = 0; n < N; n++) {
+            long chunk = std::max(1L, slice_steps[n] / samples);
+            double t = n > 0 ? slice_end_time(n - 1) : 0.0;
+            for (size_t k = 0; k < errors[n].size(); k++) {
+                double err = errors[n][k];
+                if (!(err <= slice_max[n])) slice_max[n] = err;
+                t += std::min(chunk, slice_steps[n] - (long)k * chunk) * dt;
+                if (first < 0.0 && !(err <= tolerance)) first = t;
+            }
+        }
+        return first < 0.0 ? slice_end_time(N - 1) : first;
+    }
+
+    // Fine evaluations per coarse step over fine evaluations per fine step
+    // (Heun 2, RK4 4), i.e. the cost of G relative to F.
+    double coarse_cost() const { return 2.0 / (4.0 * cfg.coarse_ratio); }
+
+    double slice_end_time(int n) const {
+        long steps = 0;
+        for (int i = 0; i <= n; i++) steps += slice_steps[i];
+        return steps * dt;
+    }
+
+    int get_iterations() const { return iterations; }
+
+    static double distance(const Vec3& a, const Vec3& b) {
+        return std::sqrt((a.x - b.x) * (a.x - b.x) + (a.y - b.y) * (a.y - b.y) + (a.z - b.z) * (a.z - b.z));
+    }
+
+private:
+    Vec3 coarse(const Vec3& u, int n) const {
+        long big = slice_steps[n] / cfg.coarse_ratio;
+        Vec3 q = sys.integrate_heun(u, dt * cfg.coarse_ratio, big);
+        q = sys.integrate_heun(q, dt, slice_steps[n] - big * cfg.coarse_ratio);
+        // Too large a step can leave the attractor, so redo the slice at the fine step.
+        if (cfg.coarse_ratio > 1 && collapsed(q)) q = sys.integrate_heun(u, dt, slice_steps[n]);
+        return q;
+    }
+
+    // Diverged (inf/NaN) or decayed into subnormals, e.g. Aizawa Heun at
+    // dt >= 0.2 spirals onto the z-axis. Both mean the predictor is lost.
+    static bool collapsed(const Vec3& q) {
+        if (!std::isfinite(q.x + q.y + q.z)) return true;
+        return std::fpclassify(q.x) == FP_SUBNORMAL || std::fpclassify(q.y) == FP_SUBNORMAL
+            || std::fpclassify(q.z) == FP_SUBNORMAL;
+    }
+
+    Vec3 fine(const Vec3& u, int n) const {
+        return sys.integrate_rk4(u, dt, slice_steps[n]);
+    }
+
+    static bool same(const Vec3& a, const Vec3& b) {
+        return a.x == b.x && a.y == b.y && a.z == b.z;
+    }
+
+    template <typename Fn>
+    static void run_parallel(const std::vector<int>& work, Fn fn) {
+        std::atomic<size_t> next(0);
+        size_t workers = std::min<size_t>(work.size(), std::max(1u, std::thread::hardware_concurrency()));
+        std::vector<std::thread> pool;
+        for (size_t w = 0; w < workers; w++) {
+            pool.emplace_back([&] {
+                for (size_t i = next++; i < work.size(); i = next++) fn(work[i]);
+            });
+        }
+        for (auto& t : pool) t.join();
+    }
+
+    const ChaosSystem& sys;
+    double dt;
+    PararealConfig cfg;
+    int iterations;
+    std::vector<long> slice_steps;
+};
+
+// attractor --parareal <steps> [slices] [iterations] [tolerance] [system] [coarse_ratio] [--u0 x y z] [--verify]
+int run_parareal(int argc, char** argv) {
+    PararealConfig cfg;
+    cfg.slices = std::max(1u, std::thread::hardware_concurrency());
+    int type = ChaosSystem::THOMAS;
+
+    HeadlessArgs args;
+    if (!parse_headless_args(argc, argv, 2, args)) {
+        std::cerr << "parareal: usage --parareal <steps> [slices] [iterations] [tolerance] [system] [coarse_ratio] [--u0 x y z] [--verify]\n";
+        return 1;
+    }
+    const std::vector<std::string>& pos = args.positional;
+    if (pos.size() > 0) cfg.steps = std::atol(pos[0].c_str());
+    if (pos.size() > 1) cfg.slices = std::atoi(pos[1].c_str());
+    // K iterations cost about K fine slices each, so K must stay well below the
+    // slice count for the parallel run to beat the serial one.
+    cfg.max_iterations = std::max(1, cfg.slices / 4);
+    if (pos.size() > 2) cfg.max_iterations = std::atoi(pos[2].c_str());
+    if (pos.size() > 3) cfg.tolerance = std::atof(pos[3].c_str());
+    if (pos.size() > 4) type = std::atoi(pos[4].c_str());
+    if (pos.size() > 5) cfg.coarse_ratio = std::atoi(pos[5].c_str());
+    // Largest Heun steps that stay on each attractor: 0.2 for Thomas, 0.04 for
+    // Lorenz (diverges from 0.08) and 0.05 for Aizawa (collapses from 0.2).
+    const int coarse_defaults[] = {4, 4, 5};
+    if (cfg.coarse_ratio == 0 && type >= 0 && type <= 2) cfg.coarse_ratio = coarse_defaults[type];
+    if (cfg.steps <= 0 || cfg.slices <= 0 || cfg.max_iterations <= 0 || cfg.coarse_ratio <= 0 || type < 0 || type > 2) {
+        std::cerr << "parareal: invalid settings\n";
+        return 1;
+    }
+
+    ChaosSystem system(static_cast<ChaosSystem::Type>(type));
+    double dt = system.step_size();
+    PararealSolver solver(system, dt, cfg);
+    Vec3 u0 = headless_start(system, args);
+
+    // Each iteration runs one serial coarse sweep and one parallel fine pass.
+    int cores = std::min<int>(cfg.slices, std::max(1u, std::thread::hardware_concurrency()));
+    double K = cfg.max_iterations, N = cfg.slices;
+    double bound = N / (N * solver.coarse_cost() * (K + 1) + K * std::ceil(N / cores));
+    std::cout << "parareal: " << cfg.steps << " RK4 steps, dt " << dt << ", " << cfg.slices << " slices, "
+              << cfg.max_iterations << " iterations, u0 (" << u0.x << ", " << u0.y << ", " << u0.z << ")\n";
+    std::cout << "parareal: best-case speedup on " << cores << " cores " << bound << "x\n";
+    if (cfg.max_iterations >= cfg.slices || cores == 1) {
+        std::cerr << "parareal: warning: with " << (cores == 1 ? "one core" : "iterations >= slices")
+                  << " the parallel run cannot beat the serial one\n";
+    }
+    if (cfg.coarse_ratio == 1) {
+        std::cerr << "parareal: warning: coarse ratio 1 makes the coarse sweep half as costly as the fine one\n";
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<Vec3> U = solver.solve(u0);
+    double parallel_secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    const Vec3& end = U.back();
+    std::cout << "parareal: " << solver.get_iterations() << " iterations, " << parallel_secs << "s, final ("
+              << end.x << ", " << end.y << ", " << end.z << ")\n";
+    if (!args.verify) return 0;
+
+    start = std::chrono::steady_clock::now();
+    std::vector<Vec3> R = solver.solve_serial(u0);
+    double serial_secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "serial:   " << serial_secs << "s, speedup " << serial_secs / parallel_secs << "x\n";
+
+    // Chaos amplifies any residual, so agreement only holds up to a horizon.
+    std::vector<double> slice_max;
+    double horizon = solver.divergence_time(U, R, PARAREAL_VERIFY_SAMPLES, cfg.tolerance, slice_max);
+    for (int n = 0; n < cfg.slices; n++) {
+        std::cout << "  slice ending t = " << solver.slice_end_time(n) << ": max error " << slice_max[n] << "\n";
+    }
+    std::cout << "agreement within " << cfg.tolerance << " up to t = " << horizon
+              << " of " << solver.slice_end_time(cfg.slices - 1) << "\n";
+    return 0;
+}
+
+// attractor --poincare <file|-> <steps> [system] [nx ny nz offset] [--u0 x y z]
+int run_poincare(int argc, char** argv) {
+    HeadlessArgs args;
+    bool parsed = parse_headless_args(argc, argv, 2, args);
+    size_t count = args.positional.size();
+    // The plane needs all four of nx ny nz offset or none of them.
+    if (!parsed || args.verify || count < 2 || (count > 3 && count != 7)) {
+        std::cerr << "poincare: usage --poincare <file|-> <steps> [system] [nx ny nz offset] [--u0 x y z]\n";
+        return 1;
+    }
+    const std::vector<std::string>& pos = args.positional;
+    const char* path = pos[0].c_str();
+    long steps = std::atol(pos[1].c_str());
+    int type = count > 2 ? std::atoi(pos[2].c_str()) : ChaosSystem::LORENZ;
+    if (steps <= 0 || type < 0 || type > 2) {
+        std::cerr << "poincare: invalid settings\n";
+        return 1;
+    }
+    // Default is the classic z = 27 section for Lorenz, z = 0 otherwise.
+    Vec3 normal = {0.0, 0.0, 1.0};
+    double offset = type == ChaosSystem::LORENZ ? 27.0 : 0.0;
+    if (count == 7) {
+        normal = {std::atof(pos[3].c_str()), std::atof(pos[4].c_str()), std::atof(pos[5].c_str())};
+        offset = std::atof(pos[6].c_str());
+    }
+
+    FILE* out = pos[0] == "-" ? stdout : fopen(path, "wb");
+#ifdef _WIN32
+    // Text mode would turn 0x0A bytes in the records into CR LF.
+    if (out == stdout) _setmode(_fileno(stdout), _O_BINARY);
+#endif
+    if (!out) {
+        std::cerr << "poincare: cannot open " << path << "\n";
+        return 1;
+    }
+
+    ChaosSystem system(static_cast<ChaosSystem::Type>(type));
+    system.set_position(headless_start(system, args));
+    double dt = system.step_size();
+    size_t crossings;
+    {
+        PoincareSection section(normal, offset, out);
+        system.attach_section(&section);
+        for (long i = 0; i < steps; i++) system.step(dt);
+        system.attach_section(nullptr);
+        crossings = section.get_count();
+    }
+    if (out != stdout) fclose(out);
+
+    std::cerr << "poincare: " << crossings << " crossings in " << steps << " steps ("
+              << crossings * sizeof(Crossing) << " bytes vs " << steps * sizeof(Vec3) << " for the full orbit)\n";
+    return 0;
+}
+
+// --- Next System Prefetch ---
+// Builds and warms up the next system on a background thread while the current
+// one plays. The finished system is published through an atomic pointer, so
+// the switch frame only swaps pointers and never waits on the worker.
+class SystemPrefetcher {
+public:
+    SystemPrefetcher() : ready(nullptr), busy(false) {}
+
+    ~SystemPrefetcher() {
+        if (worker.joinable()) worker.join();
+        delete ready.exchange(nullptr);
+    }
+
+    // Called every frame. Starts warming `type` once the previous worker has
+    // finished, which is also the only time it gets joined.
+    void prefetch(ChaosSystem::Type type) {
+        if (busy.load(std::memory_order_acquire)) return;
+        if (worker.joinable()) worker.join();
+
+        ChaosSystem* waiting = ready.load(std::memory_order_acquire);
+        if (waiting && waiting->get_type() == type) return;
+        delete ready.exchange(nullptr);
+
+        busy.store(true, std::memory_order_relaxed);
+        worker = std::thread([this, type] {
+            ChaosSystem* next = new ChaosSystem(type);
+            next->warm_up();
+            ready.store(next, std::memory_order_release);
+            busy.store(false, std::memory_order_release);
+        });
+    }
+
+    // Non-blocking. Returns nullptr if no warmed-up system of `type` is ready yet.
+    std::unique_ptr<ChaosSystem> take(ChaosSystem::Type type) {
+        std::unique_ptr<ChaosSystem> warm(ready.exchange(nullptr, std::memory_order_acq_rel));
+        if (warm && warm->get_type() != type) warm.reset();
+        return warm;
+    }
+
+private:
+    std::atomic<ChaosSystem*> ready;
+    std::atomic<bool> busy;
+    std::thread worker;
+};
+
 // --- Terminal Rendering Engine ---
 class TerminalRenderer {
 public:
@@ -174,9 +667,13 @@ private:
     std::string buffer;
 };
 
-int main() {
+int main(int argc, char** argv) {
+    if (argc > 1 && std::string(argv[1]) == "--parareal") return run_parareal(argc, argv);
+    if (argc > 1 && std::string(argv[1]) == "--poincare") return run_poincare(argc, argv);
+
     TerminalRenderer renderer;
-    ChaosSystem system(ChaosSystem::THOMAS);
+    std::unique_ptr<ChaosSystem> system(new ChaosSystem(ChaosSystem::THOMAS));
+    SystemPrefetcher prefetcher;
     
     double angle_x = 0, angle_y = 0;
     double zoom_pop = 0.1;
@@ -185,13 +682,20 @@ int main() {
         if (zoom_pop < 1.0) zoom_pop += 0.05;
         
         if (frame > 0 && frame % 800 == 0) {
-            int next = (static_cast<int>(system.get_type()) + 1) % 3;
-            system.set_type(static_cast<ChaosSystem::Type>(next));
-            zoom_pop = 0.1;
+            ChaosSystem::Type next = static_cast<ChaosSystem::Type>((static_cast<int>(system->get_type()) + 1) % 3);
+            std::unique_ptr<ChaosSystem> warm = prefetcher.take(next);
+            if (warm) {
+                system = std::move(warm);
+                zoom_pop = 1.0;
+            } else {
+                system->set_type(next);
+                zoom_pop = 0.1;
+            }
         }
+        prefetcher.prefetch(static_cast<ChaosSystem::Type>((static_cast<int>(system->get_type()) + 1) % 3));
 
-        system.update(system.get_type() == ChaosSystem::THOMAS ? 0.05 : 0.01);
-        renderer.draw(system, angle_x, angle_y, zoom_pop);
+        system->update(system->step_size());
+        renderer.draw(*system, angle_x, angle_y, zoom_pop);
 
         angle_x += 0.02;
         angle_y += 0.04;
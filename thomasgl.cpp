@@ -3,11 +3,37 @@
 #include <cmath>
 #include <vector>
 #include <ctime>
+#include <cstdio>
+#include <cstring>
+#include <cstdint>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <deque>
+#include <chrono>
+#include <algorithm>
+#include <functional>
+#include <io.h>
+#include <fcntl.h>
 
 #define MAX_PARTICLES 250000
 #define THOMAS_B 0.19f
 #define STEP_SIZE 0.012f
 #define TRAIL_FADE 0.08f
+#define EXPORT_FPS 60
+#define EXPORT_QUEUE_DEPTH 3
+#define BASIN_LANES 16
+#define BASIN_DT 0.05f
+#define BASIN_CHECK_INTERVAL 64
+#define BASIN_SETTLE_EPS 1e-10f
+#define BASIN_FIXED_RADIUS 0.01f
+#define BASIN_ORBIT_RADIUS 0.5f
+#define BASIN_WANDER_SPREAD 2.0f
+#define BASIN_ORBIT_WINDOW 1024
+#define BASIN_ORBIT_DRIFT 0.05f
+#define SECTION_BLOCK 16
+#define SECTION_BUFFER 8192
 
 struct Vec3 { float x, y, z; };
 struct Particle {
@@ -21,6 +47,95 @@ std::vector<float> colorArray;
 float rotationY = 0.0f;
 float rotationX = 0.0f;
 int width = 1200, height = 800;
+uint32_t physicsStep = 0;
+
+// --- Poincare Section ---
+// Watches update_physics() for particles crossing the plane normal . p = offset
+// in the direction of the normal. Each block of SECTION_BLOCK particles is
+// tested with one branch-free pass; only blocks that contain a crossing are
+// refined, by linear interpolation over the step, and streamed out.
+struct SectionCrossing {
+    uint32_t particle;
+    uint32_t step;
+    float frac;         // Position of the crossing within the step, 0..1
+    float x, y, z;
+};
+
+class PoincareSection {
+public:
+    PoincareSection(Vec3 normal, float offset, FILE* out)
+        : normal(normal), offset(offset), out(out), count(0) {
+        buffer.reserve(SECTION_BUFFER);
+    }
+
+    ~PoincareSection() { flush(); }
+
+    void begin_block(const Particle* block, int n) {
+        for (int k = 0; k < n; k++) {
+            prev[k] = block[k].pos;
+            before[k] = distance(block[k].pos);
+        }
+    }
+
+    void end_block(const Particle* block, uint32_t first, int n, uint32_t step) {
+        int hits = 0;
+        for (int k = 0; k < n; k++) {
+            after[k] = distance(block[k].pos);
+            hits |= (before[k] < 0.0f) & (after[k] >= 0.0f);
+        }
+        if (!hits) return;
+
+        for (int k = 0; k < n; k++) {
+            if (!(before[k] < 0.0f && after[k] >= 0.0f)) continue;
+            float f = before[k] / (before[k] - after[k]);
+            const Vec3& a = prev[k];
+            const Vec3& b = block[k].pos;
+            buffer.push_back({first + k, step, f, a.x + (b.x - a.x) * f, a.y + (b.y - a.y) * f, a.z + (b.z - a.z) * f});
+            count++;
+        }
+        if (buffer.size() + SECTION_BLOCK > buffer.capacity()) flush();
+    }
+
+    void flush() {
+        if (out && !buffer.empty()) fwrite(buffer.data(), sizeof(SectionCrossing), buffer.size(), out);
+        buffer.clear();
+    }
+
+    size_t get_count() const { return count; }
+
+private:
+    float distance(const Vec3& p) const {
+        return normal.x * p.x + normal.y * p.y + normal.z * p.z - offset;
+    }
+
+    Vec3 normal;
+    float offset;
+    FILE* out;
+    size_t count;
+    Vec3 prev[SECTION_BLOCK];
+    float before[SECTION_BLOCK], after[SECTION_BLOCK];
+    std::vector<SectionCrossing> buffer;
+};
+
+PoincareSection* section = nullptr;
+
+// Advances one particle by a single Euler step and returns its glow brightness.
+inline float advance_particle(Particle& p) {
+    float tx = sinf(p.pos.y) - THOMAS_B * p.pos.x;
+    float ty = sinf(p.pos.z) - THOMAS_B * p.pos.y;
+    float tz = sinf(p.pos.x) - THOMAS_B * p.pos.z;
+
+    p.pos.x += tx * STEP_SIZE;
+    p.pos.y += ty * STEP_SIZE;
+    p.pos.z += tz * STEP_SIZE;
+    
+    float speedSq = tx*tx + ty*ty + tz*tz;
+    p.speed = speedSq;
+
+    float brightness = 0.03f + (p.speed * 0.08f);
+    if (brightness > 0.2f) brightness = 0.2f;
+    return brightness;
+}
 
 void update_physics() {
     if (vertexArray.size() != particles.size() * 3) {
@@ -31,28 +146,36 @@ void update_physics() {
     int vIndex = 0;
     int cIndex = 0;
 
-    for (auto& p : particles) {
-        float tx = sinf(p.pos.y) - THOMAS_B * p.pos.x;
-        float ty = sinf(p.pos.z) - THOMAS_B * p.pos.y;
-        float tz = sinf(p.pos.x) - THOMAS_B * p.pos.z;
+    for (size_t base = 0; base < particles.size(); base += SECTION_BLOCK) {
+        int n = (int)std::min<size_t>(SECTION_BLOCK, particles.size() - base);
+        if (section) section->begin_block(&particles[base], n);
 
-        p.pos.x += tx * STEP_SIZE;
-        p.pos.y += ty * STEP_SIZE;
-        p.pos.z += tz * STEP_SIZE;
-        
-        float speedSq = tx*tx + ty*ty + tz*tz;
-        p.speed = speedSq;
+        for (int k = 0; k < n; k++) {
+            Particle& p = particles[base + k];
+            float brightness = advance_particle(p);
+
+            vertexArray[vIndex++] = p.pos.x * 3.2f;
+            vertexArray[vIndex++] = p.pos.y * 3.2f;
+            vertexArray[vIndex++] = p.pos.z * 3.2f;
 
-        vertexArray[vIndex++] = p.pos.x * 3.2f;
-        vertexArray[vIndex++] = p.pos.y * 3.2f;
-        vertexArray[vIndex++] = p.pos.z * 3.2f;
+            colorArray[cIndex++] = brightness * 0.9f;
+            colorArray[cIndex++] = brightness * 0.95f;
+            colorArray[cIndex++] = brightness * 1.0f;
+        }
 
-        float brightness = 0.03f + (p.speed * 0.08f);
-        if (brightness > 0.2f) brightness = 0.2f;
+        if (section) section->end_block(&particles[base], (uint32_t)base, n, physicsStep);
+    }
+    physicsStep++;
+}
 
-        colorArray[cIndex++] = brightness * 0.9f;
-        colorArray[cIndex++] = brightness * 0.95f;
-        colorArray[cIndex++] = brightness * 1.0f;
+void seed_particles(int count) {
+    particles.clear();
+    particles.reserve(count);
+    for (int i = 0; i < count; i++) {
+        particles.push_back({
+            {(float)rand()/RAND_MAX * 6 - 3, (float)rand()/RAND_MAX * 6 - 3, (float)rand()/RAND_MAX * 6 - 3},
+            0.0f
+        });
     }
 }
 
@@ -112,6 +235,640 @@ void display() {
     rotationX = 15.0f * sinf(rotationY * 0.01f);
 }
 
+// --- Offline Video Export ---
+// Headless pipeline: simulate+project -> rasterize -> write Y4M.
+// Each stage owns its own thread and hands buffers over through bounded
+// queues, empty buffers flow back through a free list so memory stays fixed.
+
+template <typename T>
+class BoundedQueue {
+public:
+    explicit BoundedQueue(size_t capacity) : capacity(capacity), closed(false) {}
+
+    void push(T item) {
+        std::unique_lock<std::mutex> lock(mutex);
+        notFull.wait(lock, [&] { return items.size() < capacity; });
+        items.push_back(item);
+        notEmpty.notify_one();
+    }
+
+    // Returns false once the queue is closed and drained.
+    bool pop(T& item) {
+        std::unique_lock<std::mutex> lock(mutex);
+        notEmpty.wait(lock, [&] { return !items.empty() || closed; });
+        if (items.empty()) return false;
+        item = items.front();
+        items.pop_front();
+        notFull.notify_one();
+        return true;
+    }
+
+    void close() {
+        std::lock_guard<std::mutex> lock(mutex);
+        closed = true;
+        notEmpty.notify_all();
+    }
+
+private:
+    size_t capacity;
+    bool closed;
+    std::deque<T> items;
+    std::mutex mutex;
+    std::condition_variable notFull, notEmpty;
+};
+
+// Fixed set of threads reused for every parallel section of a stage, so the
+// per-frame cost is a wake-up rather than a thread create/join.
+class WorkerPool {
+public:
+    explicit WorkerPool(size_t workers)
+        : workerCount(std::max<size_t>(1, workers)), job(nullptr), jobCount(0),
+          generation(0), pending(0), stopping(false) {
+        for (size_t i = 0; i < workerCount; i++) threads.emplace_back([this, i] { work(i); });
+    }
+
+    ~WorkerPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (auto& t : threads) t.join();
+    }
+
+    size_t size() const { return workerCount; }
+
+    // Splits [0, count) into one contiguous chunk per worker and waits for all of them.
+    void run(size_t count, const std::function<void(size_t, size_t)>& fn) {
+        std::unique_lock<std::mutex> lock(mutex);
+        job = &fn;
+        jobCount = count;
+        pending = workerCount;
+        generation++;
+        wake.notify_all();
+        done.wait(lock, [&] { return pending == 0; });
+        job = nullptr;
+    }
+
+private:
+    void work(size_t index) {
+        size_t seen = 0;
+        std::unique_lock<std::mutex> lock(mutex);
+        for (;;) {
+            wake.wait(lock, [&] { return stopping || generation != seen; });
+            if (stopping) return;
+            seen = generation;
+
+            size_t chunk = (jobCount + workerCount - 1) / workerCount;
+            size_t begin = std::min(index * chunk, jobCount);
+            size_t end = std::min(begin + chunk, jobCount);
+            const std::function<void(size_t, size_t)>* fn = job;
+            lock.unlock();
+            if (begin < end) (*fn)(begin, end);
+            lock.lock();
+            if (--pending == 0) done.notify_one();
+        }
+    }
+
+    size_t workerCount;
+    const std::function<void(size_t, size_t)>* job;
+    size_t jobCount;
+    size_t generation;
+    size_t pending;
+    bool stopping;
+    std::vector<std::thread> threads;
+    std::mutex mutex;
+    std::condition_variable wake, done;
+};
+
+// Projected points of one particle chunk that land in one horizontal strip.
+struct PointBin {
+    std::vector<uint32_t> pixel;
+    std::vector<float> brightness;
+};
+
+// bins[chunk * strips + strip]: each simulation chunk writes only its own row
+// of bins and each raster strip reads only its own column, so neither stage
+// needs locks or atomics.
+struct PointFrame {
+    std::vector<PointBin> bins;
+};
+
+struct VideoFrame {
+    std::vector<uint8_t> yuv;         // Planar 4:2:0, Y then Cb then Cr
+};
+
+struct ExportSettings {
+    char path[260];
+    int frames;
+    int width, height;
+    int particles;
+};
+
+// Same camera as display(): translate -17, rotate X then Y, 45 degree fov.
+void project_particles(WorkerPool& pool, PointFrame& out, int w, int h, int stripRows, float rotX, float rotY) {
+    const float deg = 3.14159f / 180.0f;
+    float cy = cosf(rotY * deg), sy = sinf(rotY * deg);
+    float cx = cosf(rotX * deg), sx = sinf(rotX * deg);
+    float f = 1.0f / tanf(45.0f * 0.5f * deg);
+    float aspect = (float)w / (float)h;
+    size_t chunks = pool.size();
+    size_t strips = out.bins.size() / chunks;
+    size_t chunkSize = (particles.size() + chunks - 1) / chunks;
+
+    pool.run(chunks, [&](size_t first, size_t last) {
+        for (size_t c = first; c < last; c++) {
+            PointBin* row = &out.bins[c * strips];
+            for (size_t s = 0; s < strips; s++) {
+                row[s].pixel.clear();
+                row[s].brightness.clear();
+            }
+
+            size_t end = std::min(particles.size(), (c + 1) * chunkSize);
+            for (size_t i = c * chunkSize; i < end; i++) {
+                Particle& p = particles[i];
+                float brightness = advance_particle(p);
+
+                float x = p.pos.x * 3.2f, y = p.pos.y * 3.2f, z = p.pos.z * 3.2f;
+                float tx = x * cy + z * sy;
+                float tz = -x * sy + z * cy;
+                float ty = y * cx - tz * sx;
+                tz = y * sx + tz * cx;
+
+                float depth = 17.0f - tz;
+                if (depth < 0.1f || depth > 100.0f) continue;
+
+                int px = (int)((tx * f / aspect / depth + 1.0f) * 0.5f * w);
+                int py = (int)((1.0f - ty * f / depth) * 0.5f * h);
+                if (px < 0 || px >= w || py < 0 || py >= h) continue;
+
+                PointBin& bin = row[py / stripRows];
+                bin.pixel.push_back((uint32_t)(py * w + px));
+                bin.brightness.push_back(brightness);
+            }
+        }
+    });
+}
+
+// Rows [y0, y1) of the accumulator to full-range BT.601 4:2:0; y0 and y1 are even.
+void accum_to_yuv420(const std::vector<float>& accum, VideoFrame& out, int w, int h, int y0, int y1) {
+    uint8_t* yPlane = out.yuv.data();
+    uint8_t* uPlane = yPlane + (size_t)w * h;
+    uint8_t* vPlane = uPlane + (size_t)(w / 2) * (h / 2);
+
+    for (int cy = y0 / 2; cy < y1 / 2; cy++) {
+        for (int cx = 0; cx < w / 2; cx++) {
+            float r = 0, g = 0, b = 0;
+            for (int k = 0; k < 4; k++) {
+                size_t idx = (size_t)(cy * 2 + k / 2) * w + cx * 2 + k % 2;
+                float pr = accum[idx * 3], pg = accum[idx * 3 + 1], pb = accum[idx * 3 + 2];
+                yPlane[idx] = (uint8_t)(255.0f * (0.299f * pr + 0.587f * pg + 0.114f * pb) + 0.5f);
+                r += pr; g += pg; b += pb;
+            }
+            r *= 0.25f; g *= 0.25f; b *= 0.25f;
+            size_t c = (size_t)cy * (w / 2) + cx;
+            uPlane[c] = (uint8_t)(128.0f + 255.0f * (-0.168736f * r - 0.331264f * g + 0.5f * b) + 0.5f);
+            vPlane[c] = (uint8_t)(128.0f + 255.0f * (0.5f * r - 0.418688f * g - 0.081312f * b) + 0.5f);
+        }
+    }
+}
+
+int run_export(const ExportSettings& cfg) {
+    int w = cfg.width & ~1, h = cfg.height & ~1;
+    if (w <= 0 || h <= 0 || cfg.frames <= 0 || cfg.particles <= 0) {
+        fprintf(stderr, "export: invalid settings\n");
+        return 1;
+    }
+
+    FILE* out = stdout;
+    if (strcmp(cfg.path, "-") == 0) {
+        _setmode(_fileno(stdout), _O_BINARY);
+    } else {
+        out = fopen(cfg.path, "wb");
+        if (!out) {
+            fprintf(stderr, "export: cannot open %s\n", cfg.path);
+            return 1;
+        }
+    }
+
+    srand(time(0));
+    seed_particles(cfg.particles);
+
+    // Simulation and rasterization overlap, so each gets its own pool.
+    size_t cores = std::max(1u, std::thread::hardware_concurrency());
+    WorkerPool simPool(cores), rasterPool(cores);
+    int stripRows = ((h + (int)cores - 1) / (int)cores + 1) & ~1;
+    int strips = (h + stripRows - 1) / stripRows;
+
+    std::vector<PointFrame> pointPool(EXPORT_QUEUE_DEPTH);
+    std::vector<VideoFrame> videoPool(EXPORT_QUEUE_DEPTH);
+    BoundedQueue<PointFrame*> freePoints(EXPORT_QUEUE_DEPTH), readyPoints(EXPORT_QUEUE_DEPTH);
+    BoundedQueue<VideoFrame*> freeVideo(EXPORT_QUEUE_DEPTH), readyVideo(EXPORT_QUEUE_DEPTH);
+    for (auto& pf : pointPool) {
+        pf.bins.resize(simPool.size() * strips);
+        freePoints.push(&pf);
+    }
+    for (auto& vf : videoPool) {
+        vf.yuv.resize((size_t)w * h * 3 / 2);
+        freeVideo.push(&vf);
+    }
+
+    // Each raster worker fades, scatters and converts its own strips of rows.
+    std::thread rasterizer([&] {
+        std::vector<float> accum((size_t)w * h * 3, 0.0f);
+        const float keep = 1.0f - TRAIL_FADE;
+        PointFrame* pf = nullptr;
+        while (readyPoints.pop(pf)) {
+            VideoFrame* vf = nullptr;
+            freeVideo.pop(vf);
+
+            rasterPool.run(strips, [&](size_t first, size_t last) {
+                for (size_t s = first; s < last; s++) {
+                    int y0 = (int)s * stripRows, y1 = std::min(h, y0 + stripRows);
+                    for (size_t i = (size_t)y0 * w * 3; i < (size_t)y1 * w * 3; i++) accum[i] *= keep;
+
+                    for (size_t c = 0; c < simPool.size(); c++) {
+                        const PointBin& bin = pf->bins[c * strips + s];
+                        for (size_t i = 0; i < bin.pixel.size(); i++) {
+                            float* px = &accum[(size_t)bin.pixel[i] * 3];
+                            float b = bin.brightness[i];
+                            px[0] = std::min(1.0f, px[0] + b * 0.9f);
+                            px[1] = std::min(1.0f, px[1] + b * 0.95f);
+                            px[2] = std::min(1.0f, px[2] + b * 1.0f);
+                        }
+                    }
+
+                    accum_to_yuv420(accum, *vf, w, h, y0, y1);
+                }
+            });
+
+            freePoints.push(pf);
+            readyVideo.push(vf);
+        }
+        readyVideo.close();
+    });
+
+    // XCOLORRANGE=FULL: C420jpeg only gives chroma siting, range must be explicit.
+    std::thread writer([&] {
+        fprintf(out, "YUV4MPEG2 W%d H%d F%d:1 Ip A1:1 C420jpeg XCOLORRANGE=FULL\n", w, h, EXPORT_FPS);
+        VideoFrame* vf = nullptr;
+        while (readyVideo.pop(vf)) {
+            fputs("FRAME\n", out);
+            fwrite(vf->yuv.data(), 1, vf->yuv.size(), out);
+            freeVideo.push(vf);
+        }
+        fflush(out);
+    });
+
+    auto start = std::chrono::steady_clock::now();
+    float rotY = 0.0f, rotX = 0.0f;
+    for (int frame = 0; frame < cfg.frames; frame++) {
+        PointFrame* pf = nullptr;
+        freePoints.pop(pf);
+        project_particles(simPool, *pf, w, h, stripRows, rotX, rotY);
+        readyPoints.push(pf);
+
+        rotY += 0.15f;
+        rotX = 15.0f * sinf(rotY * 0.01f);
+
+        if ((frame + 1) % EXPORT_FPS == 0) {
+            double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            fprintf(stderr, "export: %d/%d frames, %.1f fps\n", frame + 1, cfg.frames, (frame + 1) / secs);
+        }
+    }
+    readyPoints.close();
+
+    rasterizer.join();
+    writer.join();
+    if (out != stdout) fclose(out);
+
+    double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    fprintf(stderr, "export: %d frames in %.2fs, %.1f fps (%s real time at %d fps)\n", cfg.frames, secs,
+            cfg.frames / secs, cfg.frames / secs >= EXPORT_FPS ? "at or above" : "below", EXPORT_FPS);
+    return 0;
+}
+
+// --- Basin Of Attraction Map ---
+// Integrates a grid of initial conditions BASIN_LANES seeds at a time in
+// structure-of-arrays lanes. A lane retires as soon as its seed is classified
+// (settled on a fixed point, or two consecutive windows of an orbit agree) and
+// is refilled from a shared counter, so fast seeds never wait on slow ones.
+
+// Branch-free sine for the lane loops. A libm sinf call stops the compiler from
+// vectorizing them and MinGW has no vector math library. Rounds x / pi to the
+// nearest integer k with the 1.5 * 2^23 trick, reduces to r in [-pi/2, pi/2]
+// and evaluates the Taylor series to r^11 (error about 2e-7), sign flipped for
+// odd k.
+inline float lane_sinf(float x) {
+    float k = (x * 0.318309886f + 12582912.0f) - 12582912.0f;
+    float r = (x - k * 3.140625f) - k * 9.67653589793e-4f;
+    float sign = 1.0f - 2.0f * (float)((int)k & 1);
+    float r2 = r * r;
+    return sign * r * (1.0f + r2 * (-1.0f / 6 + r2 * (1.0f / 120 + r2 * (-1.0f / 5040
+                    + r2 * (1.0f / 362880 + r2 * (-1.0f / 39916800))))));
+}
+
+struct BasinSettings {
+    char path[260];
+    float b;
+    int resolution;     // Seeds per axis over [-3,3]
+    int depth;          // 1 = z=0 slice written as PPM, >1 = raw u8 volume
+    int maxSteps;
+};
+
+// Terminal states found so far. A seed's label is its index in this table.
+class BasinRegistry {
+public:
+    // Orbits are keyed by their mean position; wandering (chaotic) orbits
+    // have no stable mean and all share one label.
+    enum Kind { FIXED_POINT, ORBIT, WANDERING };
+    struct Entry { Kind kind; Vec3 pos; size_t count; };
+
+    uint8_t classify(Kind kind, float x, float y, float z) {
+        float radius = kind == FIXED_POINT ? BASIN_FIXED_RADIUS : BASIN_ORBIT_RADIUS;
+        std::lock_guard<std::mutex> lock(mutex);
+        for (size_t i = 0; i < entries.size(); i++) {
+            const Entry& e = entries[i];
+            if (e.kind != kind) continue;
+            float dx = e.pos.x - x, dy = e.pos.y - y, dz = e.pos.z - z;
+            if (kind == WANDERING || dx*dx + dy*dy + dz*dz < radius * radius) return (uint8_t)i;
+        }
+        if (entries.size() >= 255) return 255;
+        entries.push_back({ kind, { x, y, z }, 0 });
+        return (uint8_t)(entries.size() - 1);
+    }
+
+    // Orbit means spread over a whole cluster radius, so the first mean seen
+    // decides which seeds join a cluster. They are collected during the run
+    // and clustered afterwards in seed order, so the clusters do not depend on
+    // which thread finished first. Fixed points converge far inside their
+    // radius and wandering seeds all share one label, so those are classified
+    // immediately.
+    void add_orbit(size_t seed, float x, float y, float z) {
+        std::lock_guard<std::mutex> lock(mutex);
+        orbits.push_back({ seed, { x, y, z } });
+    }
+
+    void resolve_orbits(std::vector<uint8_t>& labels) {
+        std::sort(orbits.begin(), orbits.end(),
+                  [](const Orbit& a, const Orbit& b) { return a.seed < b.seed; });
+        for (const Orbit& o : orbits) labels[o.seed] = classify(ORBIT, o.mean.x, o.mean.y, o.mean.z);
+        orbits.clear();
+    }
+
+    // Labels are handed out in whatever order the threads first reach each
+    // state. Sorting by kind then position and remapping makes the output
+    // independent of scheduling.
+    void canonicalize(std::vector<uint8_t>& labels) {
+        std::vector<size_t> order(entries.size());
+        for (size_t i = 0; i < order.size(); i++) order[i] = i;
+        std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+            const Entry& ea = entries[a];
+            const Entry& eb = entries[b];
+            if (ea.kind != eb.kind) return ea.kind < eb.kind;
+            if (ea.pos.x != eb.pos.x) return ea.pos.x < eb.pos.x;
+            if (ea.pos.y != eb.pos.y) return ea.pos.y < eb.pos.y;
+            return ea.pos.z < eb.pos.z;
+        });
+
+        uint8_t remap[256];
+        for (int i = 0; i < 256; i++) remap[i] = (uint8_t)i;
+        std::vector<Entry> sorted;
+        for (size_t i = 0; i < order.size(); i++) {
+            remap[order[i]] = (uint8_t)i;
+            sorted.push_back(entries[order[i]]);
+        }
+        entries = sorted;
+        for (uint8_t& label : labels) label = remap[label];
+    }
+
+    std::vector<Entry> entries;
+
+private:
+    struct Orbit { size_t seed; Vec3 mean; };
+    std::vector<Orbit> orbits;
+    std::mutex mutex;
+};
+
+inline float basin_coord(size_t i, int resolution) {
+    return -3.0f + 6.0f * (i + 0.5f) / resolution;
+}
+
+void basin_worker(const BasinSettings& cfg, size_t total, std::atomic<size_t>& next,
+                  std::vector<uint8_t>& labels, BasinRegistry& registry) {
+    const size_t IDLE = SIZE_MAX;
+    const float b = cfg.b;
+    const int window = cfg.maxSteps / 4;
+    // Checks per convergence window, at most a quarter of the run.
+    const int orbitChecks = std::max(1, std::min(BASIN_ORBIT_WINDOW, window) / BASIN_CHECK_INTERVAL);
+    float x[BASIN_LANES], y[BASIN_LANES], z[BASIN_LANES];
+    float mx[BASIN_LANES], my[BASIN_LANES], mz[BASIN_LANES], msq[BASIN_LANES];
+    // Current window sums, and mean and RMS radius of the previous window
+    // (pr < 0 until the first window completes).
+    float wx[BASIN_LANES], wy[BASIN_LANES], wz[BASIN_LANES], wsq[BASIN_LANES];
+    float px[BASIN_LANES], py[BASIN_LANES], pz[BASIN_LANES], pr[BASIN_LANES];
+    size_t seed[BASIN_LANES];
+    int steps[BASIN_LANES], samples[BASIN_LANES], wsamples[BASIN_LANES];
+    int active = 0;
+
+    auto refill = [&](int l) {
+        size_t s = next.fetch_add(1);
+        if (s >= total) {
+            seed[l] = IDLE;
+            x[l] = y[l] = z[l] = 0.0f;
+            return false;
+        }
+        size_t res = cfg.resolution;
+        seed[l] = s;
+        x[l] = basin_coord(s % res, cfg.resolution);
+        y[l] = basin_coord((s / res) % res, cfg.resolution);
+        z[l] = cfg.depth > 1 ? basin_coord(s / (res * res), cfg.resolution) : 0.0f;
+        mx[l] = my[l] = mz[l] = msq[l] = 0.0f;
+        wx[l] = wy[l] = wz[l] = wsq[l] = 0.0f;
+        pr[l] = -1.0f;
+        steps[l] = samples[l] = wsamples[l] = 0;
+        return true;
+    };
+
+    for (int l = 0; l < BASIN_LANES; l++) {
+        if (refill(l)) active++;
+    }
+
+    while (active > 0) {
+        for (int k = 0; k < BASIN_CHECK_INTERVAL; k++) {
+            for (int l = 0; l < BASIN_LANES; l++) {
+                float dx = lane_sinf(y[l]) - b * x[l];
+                float dy = lane_sinf(z[l]) - b * y[l];
+                float dz = lane_sinf(x[l]) - b * z[l];
+                x[l] += dx * BASIN_DT;
+                y[l] += dy * BASIN_DT;
+                z[l] += dz * BASIN_DT;
+            }
+        }
+
+        for (int l = 0; l < BASIN_LANES; l++) {
+            if (seed[l] == IDLE) continue;
+            steps[l] += BASIN_CHECK_INTERVAL;
+
+            float dx = lane_sinf(y[l]) - b * x[l];
+            float dy = lane_sinf(z[l]) - b * y[l];
+            float dz = lane_sinf(x[l]) - b * z[l];
+            bool settled = dx*dx + dy*dy + dz*dz < BASIN_SETTLE_EPS;
+
+            if (!settled && steps[l] > cfg.maxSteps - window) {
+                mx[l] += x[l]; my[l] += y[l]; mz[l] += z[l];
+                msq[l] += x[l]*x[l] + y[l]*y[l] + z[l]*z[l];
+                samples[l]++;
+            }
+            if (!settled) {
+                wx[l] += x[l]; wy[l] += y[l]; wz[l] += z[l];
+                wsq[l] += x[l]*x[l] + y[l]*y[l] + z[l]*z[l];
+                if (++wsamples[l] == orbitChecks) {
+                    float n = (float)orbitChecks;
+                    float cx = wx[l] / n, cy = wy[l] / n, cz = wz[l] / n;
+                    float r = sqrtf(std::max(wsq[l] / n - (cx*cx + cy*cy + cz*cz), 0.0f));
+                    float ex = cx - px[l], ey = cy - py[l], ez = cz - pz[l];
+                    // A periodic orbit has the same mean and radius in every window
+                    // longer than its period; chaos keeps moving both.
+                    bool converged = pr[l] >= 0.0f && r <= BASIN_WANDER_SPREAD
+                        && ex*ex + ey*ey + ez*ez < BASIN_ORBIT_DRIFT * BASIN_ORBIT_DRIFT
+                        && fabsf(r - pr[l]) < BASIN_ORBIT_DRIFT;
+                    if (converged) {
+                        registry.add_orbit(seed[l], (cx + px[l]) / 2, (cy + py[l]) / 2, (cz + pz[l]) / 2);
+                        if (!refill(l)) active--;
+                        continue;
+                    }
+                    px[l] = cx; py[l] = cy; pz[l] = cz; pr[l] = r;
+                    wx[l] = wy[l] = wz[l] = wsq[l] = 0.0f;
+                    wsamples[l] = 0;
+                }
+            }
+            if (!settled && steps[l] < cfg.maxSteps) continue;
+
+            if (settled) {
+                labels[seed[l]] = registry.classify(BasinRegistry::FIXED_POINT, x[l], y[l], z[l]);
+            } else {
+                float n = (float)std::max(samples[l], 1);
+                float cx = mx[l] / n, cy = my[l] / n, cz = mz[l] / n;
+                float spread = msq[l] / n - (cx*cx + cy*cy + cz*cz);
+                if (spread > BASIN_WANDER_SPREAD * BASIN_WANDER_SPREAD) {
+                    labels[seed[l]] = registry.classify(BasinRegistry::WANDERING, cx, cy, cz);
+                } else {
+                    registry.add_orbit(seed[l], cx, cy, cz);
+                }
+            }
+            if (!refill(l)) active--;
+        }
+    }
+}
+
+int run_basins(const BasinSettings& cfg) {
+    if (cfg.resolution <= 0 || cfg.depth <= 0 || cfg.maxSteps <= 0) {
+        fprintf(stderr, "basins: invalid settings\n");
+        return 1;
+    }
+    int depth = cfg.depth > 1 ? cfg.resolution : 1;
+    size_t total = (size_t)cfg.resolution * cfg.resolution * depth;
+    std::vector<uint8_t> labels(total, 0);
+    BasinRegistry registry;
+    std::atomic<size_t> next(0);
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> pool;
+    unsigned workers = std::max(1u, std::thread::hardware_concurrency());
+    for (unsigned i = 0; i < workers; i++) {
+        pool.emplace_back(basin_worker, std::cref(cfg), total, std::ref(next), std::ref(labels), std::ref(registry));
+    }
+    for (auto& t : pool) t.join();
+    registry.resolve_orbits(labels);
+    double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    registry.canonicalize(labels);
+
+    FILE* out = fopen(cfg.path, "wb");
+    if (!out) {
+        fprintf(stderr, "basins: cannot open %s\n", cfg.path);
+        return 1;
+    }
+    if (depth == 1) {
+        // Row 0 is the top of the image, i.e. the largest y.
+        fprintf(out, "P6\n%d %d\n255\n", cfg.resolution, cfg.resolution);
+        for (int row = cfg.resolution - 1; row >= 0; row--) {
+            for (int col = 0; col < cfg.resolution; col++) {
+                uint8_t label = labels[(size_t)row * cfg.resolution + col];
+                float h = label * 0.618034f * 6.2831853f;
+                uint8_t rgb[3] = {
+                    (uint8_t)(127.5f + 127.5f * cosf(h)),
+                    (uint8_t)(127.5f + 127.5f * cosf(h - 2.0943951f)),
+                    (uint8_t)(127.5f + 127.5f * cosf(h + 2.0943951f))
+                };
+                fwrite(rgb, 1, 3, out);
+            }
+        }
+    } else {
+        // x fastest, then y, then z
+        fwrite(labels.data(), 1, labels.size(), out);
+    }
+    fclose(out);
+
+    for (uint8_t label : labels) {
+        if (label < registry.entries.size()) registry.entries[label].count++;
+    }
+    fprintf(stderr, "basins: %zu seeds, b=%.4f, %.2fs, %dx%dx%d u8 labels\n",
+            total, cfg.b, secs, cfg.resolution, cfg.resolution, depth);
+    const char* kindNames[] = { "fixed point", "orbit mean", "wandering" };
+    for (size_t i = 0; i < registry.entries.size(); i++) {
+        const BasinRegistry::Entry& e = registry.entries[i];
+        if (e.kind == BasinRegistry::WANDERING) {
+            fprintf(stderr, "  %3zu %-11s %zu seeds\n", i, kindNames[e.kind], e.count);
+        } else {
+            fprintf(stderr, "  %3zu %-11s (%7.3f, %7.3f, %7.3f) %zu seeds\n", i,
+                    kindNames[e.kind], e.pos.x, e.pos.y, e.pos.z, e.count);
+        }
+    }
+    return 0;
+}
+
+// thomasgl --poincare <file|-> [frames] [particles] [nx ny nz offset]
+int run_poincare(const char* args) {
+    char path[260];
+    int frames = 600, count = MAX_PARTICLES;
+    Vec3 normal = { 0.0f, 0.0f, 1.0f };
+    float offset = 0.0f;
+    int parsed = sscanf(args, "--poincare %259s %d %d %f %f %f %f", path, &frames, &count,
+                        &normal.x, &normal.y, &normal.z, &offset);
+    if (parsed < 1 || frames <= 0 || count <= 0 || (parsed > 3 && parsed < 7)) {
+        fprintf(stderr, "poincare: invalid settings\n");
+        return 1;
+    }
+
+    FILE* out = stdout;
+    if (strcmp(path, "-") == 0) {
+        _setmode(_fileno(stdout), _O_BINARY);
+    } else {
+        out = fopen(path, "wb");
+        if (!out) {
+            fprintf(stderr, "poincare: cannot open %s\n", path);
+            return 1;
+        }
+    }
+
+    srand(time(0));
+    seed_particles(count);
+    size_t crossings;
+    {
+        PoincareSection plane(normal, offset, out);
+        section = &plane;
+        for (int frame = 0; frame < frames; frame++) update_physics();
+        section = nullptr;
+        crossings = plane.get_count();
+    }
+    if (out != stdout) fclose(out);
+
+    fprintf(stderr, "poincare: %zu crossings, %zu bytes vs %zu for the full trajectories\n", crossings,
+            crossings * sizeof(SectionCrossing), (size_t)frames * count * sizeof(Vec3));
+    return 0;
+}
+
 LRESULT CALLBACK WindowProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam) {
     switch (uMsg) {
         case WM_CLOSE: 
@@ -145,6 +902,22 @@ LRESULT CALLBACK WindowProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam)
 }
 
 int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine, int nCmdShow) {
+    // thomasgl --export <file.y4m|-> [frames] [width] [height] [particles]
+    ExportSettings cfg = { "-", 600, 3840, 2160, MAX_PARTICLES };
+    if (sscanf(lpCmdLine, "--export %259s %d %d %d %d", cfg.path, &cfg.frames, &cfg.width, &cfg.height, &cfg.particles) >= 1) {
+        return run_export(cfg);
+    }
+
+    // thomasgl --basins <file> [b] [resolution] [depth] [maxSteps]
+    BasinSettings basins = { "", 0.3f, 512, 1, 20000 };
+    if (sscanf(lpCmdLine, "--basins %259s %f %d %d %d", basins.path, &basins.b, &basins.resolution, &basins.depth, &basins.maxSteps) >= 1) {
+        return run_basins(basins);
+    }
+
+    if (strncmp(lpCmdLine, "--poincare", 10) == 0) {
+        return run_poincare(lpCmdLine);
+    }
+
     WNDCLASS wc = { 0 };
     wc.lpfnWndProc = WindowProc;
     wc.hInstance = hInstance;
@@ -168,17 +941,10 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine
     wglMakeCurrent(hdc, wglCreateContext(hdc));
 
     srand(time(0));
-    particles.reserve(MAX_PARTICLES);
+    seed_particles(MAX_PARTICLES);
     vertexArray.reserve(MAX_PARTICLES * 3);
     colorArray.reserve(MAX_PARTICLES * 3);
 
-    for (int i = 0; i < MAX_PARTICLES; i++) {
-        particles.push_back({
-            {(float)rand()/RAND_MAX * 6 - 3, (float)rand()/RAND_MAX * 6 - 3, (float)rand()/RAND_MAX * 6 - 3},
-            0.0f
-        });
-    }
-
     setup_projection(w, h);
     
     while (true) {